@@ -0,0 +1,262 @@
+// Pooled, move-aware Shape object model in C++
+// Create millions of polymorphic objects per frame with almost no heap allocations.
+// Author: JBA
+// Date: 19-10-2026
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <new>
+#include <utility>
+#include <chrono>
+using namespace std;
+
+// fundamentals/polymorphism.cpp creates each shape with 'new Rectangle()' and frees it with
+// 'delete' through a Shape* pointer. That is one heap allocation (and one free) per object.
+// With 10M shapes per frame, the allocator becomes the bottleneck.
+//
+// Here we keep the same polymorphic model (a Shape base class with virtual functions), but:
+// - Each concrete type gets its own ObjectPool ("type-segregated"): all Rectangles live in big
+//   Rectangle-sized slabs, all Circles in Circle-sized slabs. Objects are built in those slabs
+//   with placement new, so creating a shape is just popping a slot from a free list.
+// - Ownership uses std::unique_ptr with a pool-aware deleter: when the pointer goes away, the
+//   object is destroyed and its slot goes back to its own pool instead of to 'delete'.
+// - Everything is move-aware: shapes have noexcept moves, and the owning pointers are move-only,
+//   so vectors of shapes grow by moving pointers, never by copying objects.
+
+class Shape {
+    public:
+        Shape() = default;
+        Shape(const Shape&) = default;
+        Shape(Shape&&) noexcept = default;
+        Shape& operator=(const Shape&) = default;
+        Shape& operator=(Shape&&) noexcept = default;
+        virtual ~Shape() = default; // Virtual: derived destructors run through a Shape pointer
+
+        virtual void display() const = 0;
+        virtual double area() const = 0;
+};
+
+class Rectangle : public Shape {
+    private:
+        double length, width;
+    public:
+        Rectangle(double l, double w) : length(l), width(w) {}
+
+        void display() const override {
+            cout << "This is a rectangle " << length << " x " << width << "." << endl;
+        }
+
+        double area() const override {
+            return length * width;
+        }
+};
+
+class Circle : public Shape {
+    private:
+        double radius;
+    public:
+        explicit Circle(double r) : radius(r) {}
+
+        void display() const override {
+            cout << "This is a circle of radius " << radius << "." << endl;
+        }
+
+        double area() const override {
+            return 3.14159265358979323846 * radius * radius;
+        }
+};
+
+// PoolDeleter:
+// The deleter stored inside each owning pointer. Different pools hold different types, so the
+// deleter remembers its pool and a function that knows the concrete type ("type erasure").
+// It is two pointers, and calling it never touches the global heap.
+struct PoolDeleter {
+    void* pool = nullptr;
+    void (*release)(void* pool, Shape* shape) = nullptr;
+
+    void operator()(Shape* shape) const {
+        if (shape != nullptr) {
+            release(pool, shape);
+        }
+    }
+};
+
+// ShapePtr: unique ownership of a pooled shape. Move-only, just like std::unique_ptr.
+using ShapePtr = unique_ptr<Shape, PoolDeleter>;
+
+// ObjectPool<T>:
+// Hands out memory for objects of exactly one type T.
+// - Memory comes in slabs (arrays of slots). Each new slab is twice as big as the previous one,
+//   so creating n objects needs only about log2(n) allocations; reserve(n) needs just one.
+// - Free slots form a linked list threaded through the slots themselves (no extra memory).
+// - Objects are constructed with placement new and destroyed by calling ~T() explicitly.
+//
+// Owning pointers keep the pool's address, so a pool is neither copyable nor movable, and it
+// must outlive every object it created.
+template <typename T>
+class ObjectPool {
+    private:
+        // A slot holds either a live T or, when free, the pointer to the next free slot.
+        union Slot {
+            Slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        vector<unique_ptr<Slot[]>> slabs; // The big blocks; freed all at once with the pool
+        Slot* freeList = nullptr;         // Slots ready to be reused
+        size_t nextSlabSize = 1024;       // Size of the next slab we will allocate
+        size_t totalSlots = 0;            // Slots in all slabs together
+        size_t liveCount = 0;             // Objects currently constructed
+
+        // addSlab: allocates one slab of 'count' slots and pushes every slot onto the free list.
+        void addSlab(size_t count) {
+            unique_ptr<Slot[]> slab(new Slot[count]);
+            // Link in reverse so the first slot of the slab is handed out first (sequential memory).
+            for (size_t i = count; i-- > 0;) {
+                slab[i].next = freeList;
+                freeList = &slab[i];
+            }
+            slabs.push_back(move(slab));
+            totalSlots += count;
+            if (nextSlabSize < count * 2) {
+                nextSlabSize = count * 2;
+            }
+        }
+
+        // releaseShape: the function stored in PoolDeleter. It restores the concrete type.
+        static void releaseShape(void* pool, Shape* shape) {
+            static_cast<ObjectPool*>(pool)->destroy(static_cast<T*>(shape));
+        }
+
+    public:
+        ObjectPool() = default;
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        ~ObjectPool() {
+            // Every object must have been destroyed before the pool goes away; the slabs are
+            // then released by their unique_ptrs.
+            if (liveCount != 0) {
+                cerr << "ObjectPool destroyed with " << liveCount << " live objects" << endl;
+            }
+        }
+
+        // reserve: make sure 'count' more objects can be created without allocating.
+        // Every slot is either live or on the free list, so the free count is O(1) to compute.
+        void reserve(size_t count) {
+            size_t available = totalSlots - liveCount;
+            if (available < count) {
+                addSlab(count - available);
+            }
+        }
+
+        // create: constructs a T in a free slot (placement new) and returns a raw pointer.
+        template <typename... Args>
+        T* create(Args&&... args) {
+            if (freeList == nullptr) {
+                addSlab(nextSlabSize);
+            }
+            Slot* slot = freeList;
+            freeList = slot->next;
+            T* object = new (slot->storage) T(forward<Args>(args)...);
+            liveCount++;
+            return object;
+        }
+
+        // destroy: runs the destructor and puts the slot back on the free list.
+        void destroy(T* object) {
+            object->~T();
+            Slot* slot = reinterpret_cast<Slot*>(object);
+            slot->next = freeList;
+            freeList = slot;
+            liveCount--;
+        }
+
+        // make: like create(), but returns an owning ShapePtr that gives the slot back by itself.
+        template <typename... Args>
+        ShapePtr make(Args&&... args) {
+            return ShapePtr(create(forward<Args>(args)...), PoolDeleter{this, &ObjectPool::releaseShape});
+        }
+
+        size_t slabCount() const { return slabs.size(); }
+        size_t size() const { return liveCount; }
+};
+
+int main() {
+    // The polymorphic behavior is exactly the same as with new/delete.
+    ObjectPool<Rectangle> rectangles;
+    ObjectPool<Circle> circles;
+    {
+        ShapePtr shape = rectangles.make(5.0, 3.0);
+        shape->display(); // Calls Rectangle's display
+        ShapePtr other = move(shape); // Ownership moves, the object itself stays where it is
+        cout << "Area: " << other->area() << ", moved-from pointer is "
+             << (shape ? "set" : "empty") << endl;
+    } // 'other' goes out of scope: the rectangle returns to its pool, no 'delete'
+
+    // One "frame": build many shapes, use them, drop them. Everything is reserved up front:
+    // 'rectangles' already has the 1024-slot slab from the block above and adds one slab for the
+    // rest, 'circles' adds one slab, and 'scene' reserves its vector once. The frames themselves
+    // then allocate nothing: clear() hands every slot back to its pool for the next frame.
+    const size_t perFrame = 2000000;
+    const int frames = 3;
+    vector<ShapePtr> scene;
+    scene.reserve(perFrame);
+    rectangles.reserve(perFrame / 2);
+    circles.reserve(perFrame / 2);
+
+    auto start = chrono::steady_clock::now();
+    double total = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (size_t i = 0; i < perFrame; ++i) {
+            if (i % 2 == 0) {
+                scene.push_back(rectangles.make(1.0 + i % 7, 2.0));
+            } else {
+                scene.push_back(circles.make(1.0 + i % 5));
+            }
+        }
+        for (const ShapePtr& s : scene) {
+            total += s->area();
+        }
+        scene.clear(); // Every slot goes back to its pool, ready for the next frame
+    }
+    double pooledSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Pooled: " << frames << " frames x " << perFrame << " shapes in " << pooledSeconds
+         << " s, slabs allocated: " << rectangles.slabCount() + circles.slabCount()
+         << ", total area " << total << endl;
+
+    // The same work with one new/delete per shape, for comparison.
+    vector<unique_ptr<Shape>> heapScene;
+    heapScene.reserve(perFrame);
+    start = chrono::steady_clock::now();
+    total = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (size_t i = 0; i < perFrame; ++i) {
+            if (i % 2 == 0) {
+                heapScene.push_back(unique_ptr<Shape>(new Rectangle(1.0 + i % 7, 2.0)));
+            } else {
+                heapScene.push_back(unique_ptr<Shape>(new Circle(1.0 + i % 5)));
+            }
+        }
+        for (const unique_ptr<Shape>& s : heapScene) {
+            total += s->area();
+        }
+        heapScene.clear();
+    }
+    double heapSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "new/delete: " << frames << " frames x " << perFrame << " shapes in " << heapSeconds
+         << " s, heap allocations: " << frames * perFrame << ", total area " << total << endl;
+
+    return 0;
+}
+
+// In summary:
+// - Each concrete shape type has its own pool of same-sized slots, filled with placement new.
+// - unique_ptr with a pool-aware deleter keeps ownership automatic and returns slots to the pool.
+// - Moves transfer pointers only, so containers of shapes never copy or reallocate objects.
+//
+// Compile the program
+// g++ -std=c++17 -O2 -o pooled_shapes pooled_shapes.cpp
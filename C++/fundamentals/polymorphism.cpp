@@ -20,7 +20,7 @@ class Rectangle : public Shape {
 };
 
 int main() {
-    Shape* shape = new Rectangle();
+    Shape* shape = new Rectangle(); // One heap allocation per shape (see ../efficiency_and_memory_optimization/pooled_shapes.cpp)
     shape -> display(); // Calls Rectangles display
     delete shape;
     return 0;
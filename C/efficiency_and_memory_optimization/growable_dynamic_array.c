@@ -0,0 +1,330 @@
+// Growable Dynamic Array - C Programming
+// Amortized growth, small-buffer optimization and huge-page backing for large AI arrays.
+// Author: JBA
+// Date: 19-10-2026
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // Needed for mremap() and MREMAP_MAYMOVE on Linux
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DYNARRAY_HAVE_MMAP 1
+#endif
+
+// fundamentals/memory_management/dinamic_array_allocation.c allocates 'n' ints once with malloc:
+// the array can never grow, and n * sizeof(int) is not checked for overflow.
+//
+// This file builds a reusable growable array (like C++'s std::vector) for any element type.
+// The code only uses casts that C++ also accepts, so it compiles as C or as C++.
+// It uses a different storage strategy depending on how big the array is:
+//
+// 1. INLINE: tiny arrays live in a buffer inside the struct itself -> no malloc at all.
+//    In AI code there are many tiny arrays (shapes, strides, small token lists).
+// 2. HEAP: medium arrays use malloc/realloc like usual.
+// 3. MAPPED: large arrays (>= 1 MB) get their own pages from the OS with mmap().
+//    On Linux, growing them uses mremap(), which moves page table entries instead of copying
+//    bytes, so a multi-GB array grows without copying its data. Optionally we ask the kernel
+//    for transparent huge pages (2 MB instead of 4 KB), which cuts TLB misses on big scans.
+//
+// Capacity always grows geometrically (doubling), so pushing n elements costs O(n) in total:
+// each element is copied at most a constant number of times on average ("amortized O(1)").
+
+// Bytes available in the inline buffer. 64 bytes = 16 ints or 8 doubles.
+#define DYNARRAY_INLINE_BYTES 64
+
+// Arrays at least this big (in bytes) are backed by mmap() instead of malloc().
+#define DYNARRAY_MMAP_THRESHOLD (1u << 20)
+
+// Transparent huge pages on x86-64 are 2 MB.
+#define DYNARRAY_HUGE_PAGE_SIZE (2u << 20)
+
+// Flags for dynArrayInit()
+#define DYNARRAY_HUGEPAGES 1 // Ask for huge pages when the array becomes MAPPED
+
+// Where the elements currently live
+typedef enum {
+    DYNARRAY_INLINE,
+    DYNARRAY_HEAP,
+    DYNARRAY_MAPPED
+} DynArrayStorage;
+
+// The DynArray struct tracks:
+// - 'heap': pointer to the elements when they are on the heap or mapped (unused when INLINE).
+// - 'size': how many elements are stored.
+// - 'capacity': how many elements fit before we need to grow.
+// - 'elemSize': size in bytes of one element.
+// - 'mappedBytes': size of the mmap() region (page-rounded) when MAPPED.
+// - 'inlineBuffer': the small buffer used while the array is tiny. The union forces it to be
+//   aligned for any basic type.
+//
+// Because the inline buffer is inside the struct, never copy a DynArray by value: always pass
+// a pointer and use dynArrayData() to reach the elements.
+typedef struct {
+    void *heap;
+    size_t size;
+    size_t capacity;
+    size_t elemSize;
+    size_t mappedBytes;
+    DynArrayStorage storage;
+    int flags;
+    union {
+        long double alignLongDouble;
+        void *alignPointer;
+        long long alignLongLong;
+        unsigned char bytes[DYNARRAY_INLINE_BYTES];
+    } inlineBuffer;
+} DynArray;
+
+// dynArrayInit:
+// Prepares an empty array of elements of 'elemSize' bytes. No memory is allocated yet:
+// the first elements go into the inline buffer.
+// Returns 0 on success, -1 if elemSize is 0 (the array is then left empty and every push fails).
+int dynArrayInit(DynArray *a, size_t elemSize, int flags) {
+    a->heap = NULL;
+    a->size = 0;
+    a->elemSize = elemSize;
+    a->capacity = (elemSize != 0 && elemSize <= DYNARRAY_INLINE_BYTES) ? DYNARRAY_INLINE_BYTES / elemSize : 0;
+    a->mappedBytes = 0;
+    a->storage = DYNARRAY_INLINE;
+    a->flags = flags;
+    return elemSize != 0 ? 0 : -1;
+}
+
+// dynArrayData: returns a pointer to the first element, wherever the elements live.
+void *dynArrayData(DynArray *a) {
+    return a->storage == DYNARRAY_INLINE ? (void *)a->inlineBuffer.bytes : a->heap;
+}
+
+// dynArrayAt: returns a pointer to element 'i' (no bounds check, like arr[i]).
+void *dynArrayAt(DynArray *a, size_t i) {
+    return (char *)dynArrayData(a) + i * a->elemSize;
+}
+
+#ifdef DYNARRAY_HAVE_MMAP
+// roundUpToPages: rounds 'bytes' up to a whole number of pages (huge pages if requested).
+// Returns 0 if the rounding overflows.
+static size_t roundUpToPages(size_t bytes, int flags) {
+    size_t page = (flags & DYNARRAY_HUGEPAGES) ? DYNARRAY_HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+    if (bytes > SIZE_MAX - (page - 1)) {
+        return 0;
+    }
+    return (bytes + page - 1) / page * page;
+}
+
+// adviseHugePages: tells Linux it may back this region with transparent huge pages.
+// It is only a hint: if THP is disabled the call fails harmlessly and we keep 4 KB pages.
+static void adviseHugePages(void *mem, size_t bytes, int flags) {
+#ifdef MADV_HUGEPAGE
+    if (flags & DYNARRAY_HUGEPAGES) {
+        madvise(mem, bytes, MADV_HUGEPAGE);
+    }
+#else
+    (void)mem;
+    (void)bytes;
+    (void)flags;
+#endif
+}
+
+// growMapped:
+// Moves the array into (or grows) an mmap() region of at least 'bytes' bytes.
+// Returns 0 on success, -1 on failure (the array is left unchanged).
+static int growMapped(DynArray *a, size_t bytes) {
+    size_t mapBytes = roundUpToPages(bytes, a->flags);
+    if (mapBytes == 0) {
+        return -1;
+    }
+    void *mem;
+#ifdef MREMAP_MAYMOVE
+    if (a->storage == DYNARRAY_MAPPED) {
+        // The kernel re-points the existing pages at a (possibly) new address range:
+        // no element is copied, no matter how many gigabytes the array holds.
+        mem = mremap(a->heap, a->mappedBytes, mapBytes, MREMAP_MAYMOVE);
+        if (mem == MAP_FAILED) {
+            return -1;
+        }
+        adviseHugePages(mem, mapBytes, a->flags);
+        a->heap = mem;
+        a->mappedBytes = mapBytes;
+        return 0;
+    }
+#endif
+    mem = mmap(NULL, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return -1;
+    }
+    adviseHugePages(mem, mapBytes, a->flags);
+    // Without mremap() (e.g. macOS) or when coming from the heap, copy the elements over once.
+    memcpy(mem, dynArrayData(a), a->size * a->elemSize);
+    if (a->storage == DYNARRAY_MAPPED) {
+        munmap(a->heap, a->mappedBytes);
+    } else if (a->storage == DYNARRAY_HEAP) {
+        free(a->heap);
+    }
+    a->heap = mem;
+    a->mappedBytes = mapBytes;
+    a->storage = DYNARRAY_MAPPED;
+    return 0;
+}
+#endif
+
+// dynArrayReserve:
+// Makes sure the array can hold at least 'minCapacity' elements without growing again.
+// The capacity at least doubles each time, which is what makes push amortized O(1).
+// Returns 0 on success, -1 if the size overflows or memory allocation fails.
+int dynArrayReserve(DynArray *a, size_t minCapacity) {
+    if (minCapacity <= a->capacity) {
+        return 0;
+    }
+    // Overflow check: minCapacity * elemSize must fit in size_t (and elements must have a size).
+    if (a->elemSize == 0 || minCapacity > SIZE_MAX / a->elemSize) {
+        return -1;
+    }
+    size_t newCapacity = a->capacity > SIZE_MAX / a->elemSize / 2 ? SIZE_MAX / a->elemSize : a->capacity * 2;
+    if (newCapacity < minCapacity) {
+        newCapacity = minCapacity;
+    }
+    if (newCapacity < 4) {
+        newCapacity = 4;
+    }
+    size_t bytes = newCapacity * a->elemSize;
+
+#ifdef DYNARRAY_HAVE_MMAP
+    if (bytes >= DYNARRAY_MMAP_THRESHOLD) {
+        if (growMapped(a, bytes) != 0) {
+            return -1;
+        }
+        // Pages are whole, so we may have received a bit more room than we asked for.
+        a->capacity = a->mappedBytes / a->elemSize;
+        return 0;
+    }
+#endif
+
+    if (a->storage == DYNARRAY_HEAP) {
+        // realloc can often extend the block in place; otherwise it copies for us.
+        void *grown = realloc(a->heap, bytes);
+        if (grown == NULL) {
+            return -1;
+        }
+        a->heap = grown;
+    } else {
+        // Leaving the inline buffer: this is the first real allocation of the array.
+        void *mem = malloc(bytes);
+        if (mem == NULL) {
+            return -1;
+        }
+        memcpy(mem, a->inlineBuffer.bytes, a->size * a->elemSize);
+        a->heap = mem;
+        a->storage = DYNARRAY_HEAP;
+    }
+    a->capacity = newCapacity;
+    return 0;
+}
+
+// dynArrayPush:
+// Appends one element (copied from 'elem'), growing the array if needed.
+// Returns 0 on success, -1 on failure.
+int dynArrayPush(DynArray *a, const void *elem) {
+    if (a->size == a->capacity && dynArrayReserve(a, a->size + 1) != 0) {
+        return -1;
+    }
+    memcpy((char *)dynArrayData(a) + a->size * a->elemSize, elem, a->elemSize);
+    a->size++;
+    return 0;
+}
+
+// dynArrayFree:
+// Releases the array's memory (if any) and leaves it empty and ready for reuse.
+void dynArrayFree(DynArray *a) {
+#ifdef DYNARRAY_HAVE_MMAP
+    if (a->storage == DYNARRAY_MAPPED) {
+        munmap(a->heap, a->mappedBytes);
+    }
+#endif
+    if (a->storage == DYNARRAY_HEAP) {
+        free(a->heap);
+    }
+    dynArrayInit(a, a->elemSize, a->flags);
+}
+
+// storageName: human-readable storage mode for the demo output.
+static const char *storageName(DynArrayStorage s) {
+    switch (s) {
+        case DYNARRAY_INLINE: return "inline";
+        case DYNARRAY_HEAP:   return "heap";
+        case DYNARRAY_MAPPED: return "mapped";
+    }
+    return "?";
+}
+
+int main() {
+    DynArray small;
+    dynArrayInit(&small, sizeof(int), 0);
+
+    // Ten ints fit in the 64-byte inline buffer: no malloc is performed here.
+    for (int i = 0; i < 10; ++i) {
+        int value = i + 1;
+        dynArrayPush(&small, &value);
+    }
+    printf("Small array (%s): ", storageName(small.storage));
+    for (size_t i = 0; i < small.size; ++i) {
+        printf("%d ", *(int *)dynArrayAt(&small, i));
+    }
+    printf("\n");
+    dynArrayFree(&small);
+
+    // A large array of 64M ints (256 MB) that grows from empty, one push at a time.
+    // In AI pipelines this could be a token stream or a feature column read from disk.
+    DynArray big;
+    dynArrayInit(&big, sizeof(int), DYNARRAY_HUGEPAGES);
+    size_t n = (size_t)64 << 20;
+    int growths = 0, moves = 0;
+    void *lastData = dynArrayData(&big);
+    size_t lastCapacity = big.capacity;
+
+    clock_t start = clock();
+    for (size_t i = 0; i < n; ++i) {
+        int value = (int)i;
+        if (dynArrayPush(&big, &value) != 0) {
+            printf("Memory allocation failed\n");
+            dynArrayFree(&big);
+            return 1;
+        }
+        if (big.capacity != lastCapacity) {
+            growths++;
+            if (dynArrayData(&big) != lastData) {
+                moves++;
+            }
+            lastCapacity = big.capacity;
+            lastData = dynArrayData(&big);
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Big array (%s): %zu elements, capacity %zu, %d growths, %d address changes, %.3f s\n",
+        storageName(big.storage), big.size, big.capacity, growths, moves, seconds);
+    printf("Last element: %d\n", *(int *)dynArrayAt(&big, big.size - 1));
+
+    // Overflow is detected instead of silently allocating a too-small block.
+    DynArray huge;
+    dynArrayInit(&huge, sizeof(int), 0);
+    if (dynArrayReserve(&huge, SIZE_MAX / 2) != 0) {
+        printf("Reserving SIZE_MAX / 2 ints correctly failed (size overflow)\n");
+    }
+
+    dynArrayFree(&big);
+    return 0;
+}
+
+// In summary:
+// - Doubling the capacity makes appends amortized O(1).
+// - Tiny arrays stay inside the struct (no malloc), medium ones use malloc/realloc.
+// - Large arrays use mmap(), grow with mremap() on Linux (no copying), and can use huge pages.
+// - Every size computation is checked for overflow before allocating.
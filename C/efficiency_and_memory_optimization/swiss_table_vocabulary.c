@@ -0,0 +1,718 @@
+// Open-addressing SIMD Hash Table for Vocabularies - C Programming
+// Map terms to column indices fast, to fill a SparseMatrix from real text.
+// Author: JBA
+// Date: 19-10-2026
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // Needed for clock_gettime(), CLOCK_MONOTONIC and pthreads with -std=c11
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h> // SSE2 intrinsics: compare 16 control bytes at once
+#endif
+
+// sparse_matrix_repres.c mentions the "bag-of-words" model: every document is a row, every
+// distinct term is a column. Before we can store (row, col, value) we need a dictionary that
+// maps each term string to its column index. With 100M+ tokens that dictionary is the hot spot.
+//
+// A node-based hash map (like std::unordered_map) does one malloc per entry and follows a
+// pointer per lookup. This file uses the design popularized by Google's "Swiss tables":
+//
+// 1. Flat open addressing: all entries live in one array, no per-entry allocation.
+// 2. A separate array of 1-byte "control bytes", one per slot. A control byte is either EMPTY or
+//    7 bits of the key's hash (called H2). Slots are grouped in 16s, and one SSE2 instruction
+//    compares all 16 control bytes of a group against H2. Only slots whose byte matches (on
+//    average far less than one per lookup) need a real string comparison.
+// 3. String interning: each distinct term is copied once into an arena (a memory pool of big
+//    chunks, as in memo_pool_freq_alloc.c) and every later occurrence reuses that copy.
+// 4. A sharded variant for multi-threaded vocabulary building: the hash picks one of many
+//    independent tables, each with its own lock, so threads rarely wait for each other.
+//
+// Terms are only ever added (a vocabulary never forgets a word), so there is no erase and no
+// "deleted" marker to deal with.
+
+#define GROUP_WIDTH 16             // Slots probed together (one SSE2 register of control bytes)
+#define CTRL_EMPTY ((int8_t)-128)  // 0x80: the high bit marks an empty slot; full slots hold 0..127
+
+/* ------------------------------------------------------------------------------------------
+ * String arena
+ * ------------------------------------------------------------------------------------------ */
+
+// The arena hands out memory from big chunks, like the MemoryPool in memo_pool_freq_alloc.c,
+// but when a chunk is full it starts a new one instead of failing.
+//
+// A string is named by a 32-bit "handle" instead of an 8-byte pointer, to keep hash slots small:
+// the high bits are the chunk number and the low ARENA_CHUNK_BITS bits the offset inside it.
+// Each string is stored as [4-byte length][bytes]['\0'], so the table never stores lengths.
+// Chunks never move, so pointers to the strings stay valid until the arena is freed.
+#define ARENA_CHUNK_BITS 20
+#define ARENA_CHUNK_SIZE (1u << ARENA_CHUNK_BITS)
+#define ARENA_MAX_CHUNKS (1u << (32 - ARENA_CHUNK_BITS)) // 4096 chunks = 4 GB of terms
+
+typedef struct {
+    char **chunks;          // All chunks, in allocation order
+    uint32_t chunkCount;
+    uint32_t chunkCapacity;
+    size_t lastUsed;        // Bytes handed out from the last chunk
+    size_t lastSize;        // Size of the last chunk
+} StringArena;
+
+// arenaCopyString: stores 'len' bytes (with length header and '\0') and returns the handle.
+static uint32_t arenaCopyString(StringArena *arena, const char *str, size_t len) {
+    size_t need = sizeof(uint32_t) + len + 1;
+    if (arena->chunkCount == 0 || arena->lastUsed + need > arena->lastSize) {
+        if (arena->chunkCount == ARENA_MAX_CHUNKS) {
+            fprintf(stderr, "String arena is full\n");
+            exit(1);
+        }
+        if (arena->chunkCount == arena->chunkCapacity) {
+            uint32_t newCapacity = arena->chunkCapacity ? arena->chunkCapacity * 2 : 16;
+            char **grown = (char **)realloc(arena->chunks, newCapacity * sizeof(char *));
+            if (grown == NULL) {
+                fprintf(stderr, "Arena allocation failed\n");
+                exit(1);
+            }
+            arena->chunks = grown;
+            arena->chunkCapacity = newCapacity;
+        }
+        // A term longer than a chunk simply gets a chunk of its own (it starts at offset 0).
+        size_t size = need > ARENA_CHUNK_SIZE ? need : ARENA_CHUNK_SIZE;
+        char *chunk = (char *)malloc(size);
+        if (chunk == NULL) {
+            fprintf(stderr, "Arena allocation failed\n");
+            exit(1);
+        }
+        arena->chunks[arena->chunkCount++] = chunk;
+        arena->lastUsed = 0;
+        arena->lastSize = size;
+    }
+    uint32_t chunkIndex = arena->chunkCount - 1;
+    char *entry = arena->chunks[chunkIndex] + arena->lastUsed;
+    uint32_t len32 = (uint32_t)len;
+    memcpy(entry, &len32, sizeof(uint32_t));
+    memcpy(entry + sizeof(uint32_t), str, len);
+    entry[sizeof(uint32_t) + len] = '\0';
+    uint32_t handle = (chunkIndex << ARENA_CHUNK_BITS) | (uint32_t)arena->lastUsed;
+    arena->lastUsed += need;
+    return handle;
+}
+
+// arenaString / arenaLength: the bytes and the length of the string behind a handle.
+static const char *arenaString(const StringArena *arena, uint32_t handle) {
+    return arena->chunks[handle >> ARENA_CHUNK_BITS] + (handle & (ARENA_CHUNK_SIZE - 1)) + sizeof(uint32_t);
+}
+
+static size_t arenaLength(const StringArena *arena, uint32_t handle) {
+    uint32_t len;
+    memcpy(&len, arena->chunks[handle >> ARENA_CHUNK_BITS] + (handle & (ARENA_CHUNK_SIZE - 1)), sizeof(uint32_t));
+    return len;
+}
+
+// freeArena: releases every chunk at once.
+static void freeArena(StringArena *arena) {
+    for (uint32_t i = 0; i < arena->chunkCount; ++i) {
+        free(arena->chunks[i]);
+    }
+    free(arena->chunks);
+    arena->chunks = NULL;
+    arena->chunkCount = 0;
+    arena->chunkCapacity = 0;
+    arena->lastUsed = 0;
+    arena->lastSize = 0;
+}
+
+/* ------------------------------------------------------------------------------------------
+ * Swiss-table style hash table: term -> column
+ * ------------------------------------------------------------------------------------------ */
+
+// One slot of the table: 16 bytes, four per cache line.
+// With millions of terms the slot array does not fit in cache, so every lookup pays one miss on
+// the control bytes and one on the slot; smaller slots mean less memory traffic for both.
+// 'key' holds the first 7 bytes of the term plus a length byte. Terms of up to 7 bytes (most
+// words) are compared with that one 64-bit compare and never touch the arena; longer terms
+// compare the rest of their bytes in the arena.
+#define INLINE_KEY_BYTES 7
+
+typedef struct {
+    uint32_t term;    // Arena handle of the interned term
+    int col;          // Column index in the SparseMatrix
+    uint64_t key;     // Inline bytes + length byte, see termKey()
+} VocabSlot;
+
+// The Vocabulary struct tracks:
+// - 'ctrl' / 'slots': control bytes and entries, 'capacity' of each (a power of two, >= 16).
+// - 'size': number of distinct terms stored.
+// - 'terms': reverse map, terms[col] is the term of column col.
+// - 'arena': where the term strings are stored.
+typedef struct {
+    int8_t *ctrl;
+    VocabSlot *slots;
+    size_t capacity;
+    size_t size;
+    const char **terms;
+    size_t termsCapacity;
+    StringArena arena;
+} Vocabulary;
+
+// load32 / load64: little-endian loads of 4 / 8 bytes. Compilers turn these into one mov on x86
+// and ARM, and the result is the same on big-endian machines.
+static uint32_t load32(const char *p) {
+    const unsigned char *b = (const unsigned char *)p;
+    return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+}
+
+static uint64_t load64(const char *p) {
+    return (uint64_t)load32(p) | (uint64_t)load32(p + 4) << 32;
+}
+
+// termKey:
+// Packs the first 7 bytes of a term (little-endian, zero-padded) and a length byte into 64 bits.
+// The length byte is 'len' for short terms and 0x80 | (len & 0x7f) for long ones, so two short
+// terms have equal keys exactly when they are equal, even if they contain '\0' bytes.
+// Short terms are read with a few fixed-size (possibly overlapping) loads instead of a
+// variable-length memcpy: a memcpy of 'len' bytes branches on 'len', and mispredicting those
+// branches on every token cost more than the cache misses of the table itself.
+static uint64_t termKey(const char *str, size_t len) {
+    uint64_t bytes;
+    if (len > INLINE_KEY_BYTES) {
+        bytes = load64(str) & 0x00FFFFFFFFFFFFFFull;
+        return bytes | (uint64_t)(0x80 | (len & 0x7f)) << 56;
+    }
+    if (len >= 4) {
+        // The first and the last 4 bytes, overlapping when len < 8.
+        bytes = (uint64_t)load32(str) | (uint64_t)load32(str + len - 4) << (8 * (len - 4));
+    } else if (len > 0) {
+        // Bytes 0, len / 2 and len - 1 cover every byte of a 1-3 byte term.
+        const unsigned char *b = (const unsigned char *)str;
+        bytes = (uint64_t)b[0] | (uint64_t)b[len / 2] << (8 * (len / 2)) | (uint64_t)b[len - 1] << (8 * (len - 1));
+    } else {
+        bytes = 0;
+    }
+    return bytes | (uint64_t)len << 56;
+}
+
+// mixHash: multiply / xor-shift finalizer, so every output bit depends on every input bit
+// (both the low "position" bits and the 7 H2 bits must be good).
+static uint64_t mixHash(uint64_t h) {
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ull;
+    h ^= h >> 32;
+    return h;
+}
+
+// hashKey: the hash of a term of up to 7 bytes, from its key (which holds the whole term).
+static uint64_t hashKey(uint64_t key) {
+    return mixHash(key * 0x9E3779B97F4A7C15ull);
+}
+
+// hashTerm:
+// A term of up to 7 bytes is hashed from its key (see hashKey()).
+// Longer terms are hashed 8 bytes at a time; the last, partial word is the last 8 bytes of the
+// term, overlapping the previous word, so there is no variable-length tail to copy.
+static uint64_t hashTerm(const char *str, size_t len) {
+    const uint64_t m = 0x9E3779B97F4A7C15ull;
+    if (len <= INLINE_KEY_BYTES) {
+        return hashKey(termKey(str, len));
+    }
+    uint64_t h = 0x243F6A8885A308D3ull ^ (len * m);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        h = (h ^ load64(str + i)) * m;
+        h ^= h >> 29;
+    }
+    if (i < len) {
+        h = (h ^ load64(str + len - 8)) * m;
+        h ^= h >> 29;
+    }
+    return mixHash(h);
+}
+
+// H1 picks the starting group, H2 is the 7-bit tag stored in the control byte.
+static size_t hashH1(uint64_t hash) { return (size_t)(hash >> 7); }
+static int8_t hashH2(uint64_t hash) { return (int8_t)(hash & 0x7f); }
+
+// groupMatch:
+// Returns a 16-bit mask with bit i set when ctrl[i] == tag.
+static uint32_t groupMatch(const int8_t *ctrl, int8_t tag) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag)));
+#else
+    // Portable fallback: the same answer, one byte at a time.
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i) {
+        mask |= (uint32_t)(ctrl[i] == tag) << i;
+    }
+    return mask;
+#endif
+}
+
+// lowestBit: index of the lowest set bit of a non-zero mask.
+static int lowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+// allocateTable: gives the vocabulary 'capacity' empty slots.
+static void allocateTable(Vocabulary *v, size_t capacity) {
+    v->ctrl = (int8_t *)malloc(capacity);
+    v->slots = (VocabSlot *)malloc(capacity * sizeof(VocabSlot));
+    if (v->ctrl == NULL || v->slots == NULL) {
+        fprintf(stderr, "Hash table allocation failed\n");
+        exit(1);
+    }
+    memset(v->ctrl, CTRL_EMPTY, capacity);
+    v->capacity = capacity;
+}
+
+// vocabInit: prepares an empty vocabulary.
+void vocabInit(Vocabulary *v) {
+    allocateTable(v, 1024);
+    v->size = 0;
+    v->terms = NULL;
+    v->termsCapacity = 0;
+    memset(&v->arena, 0, sizeof(v->arena));
+}
+
+// findEmptySlot:
+// Probes group after group (quadratic / triangular sequence: +1, +2, +3 ... groups) until it
+// finds an EMPTY control byte. The table is never full, so this always terminates.
+static size_t findEmptySlot(const Vocabulary *v, uint64_t hash) {
+    size_t groupMask = v->capacity / GROUP_WIDTH - 1;
+    size_t g = hashH1(hash) & groupMask;
+    for (size_t step = 1;; ++step) {
+        uint32_t empty = groupMatch(v->ctrl + g * GROUP_WIDTH, CTRL_EMPTY);
+        if (empty) {
+            return g * GROUP_WIDTH + (size_t)lowestBit(empty);
+        }
+        g = (g + step) & groupMask;
+    }
+}
+
+// slotHash:
+// Recomputes a stored term's hash (slots do not keep it, to stay small). Short terms are
+// hashed from the inline key; only long ones read the arena.
+static uint64_t slotHash(const Vocabulary *v, const VocabSlot *slot) {
+    if ((slot->key >> 56) <= INLINE_KEY_BYTES) {
+        return hashKey(slot->key);
+    }
+    return hashTerm(arenaString(&v->arena, slot->term), arenaLength(&v->arena, slot->term));
+}
+
+// growTable:
+// Doubles the capacity and moves every slot to its new position. Growth happens only
+// log2(n) times, so re-hashing the terms here is cheaper than storing every hash.
+static void growTable(Vocabulary *v) {
+    int8_t *oldCtrl = v->ctrl;
+    VocabSlot *oldSlots = v->slots;
+    size_t oldCapacity = v->capacity;
+
+    allocateTable(v, oldCapacity * 2);
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldCtrl[i] != CTRL_EMPTY) {
+            size_t s = findEmptySlot(v, slotHash(v, &oldSlots[i]));
+            v->ctrl[s] = oldCtrl[i];
+            v->slots[s] = oldSlots[i];
+        }
+    }
+    free(oldCtrl);
+    free(oldSlots);
+}
+
+// findSlot:
+// Returns the slot index holding 'str', or -1 if the term is not in the table.
+static long findSlot(const Vocabulary *v, const char *str, size_t len, uint64_t hash) {
+    size_t groupMask = v->capacity / GROUP_WIDTH - 1;
+    size_t g = hashH1(hash) & groupMask;
+    int8_t tag = hashH2(hash);
+    uint64_t key = termKey(str, len);
+    for (size_t step = 1;; ++step) {
+        const int8_t *ctrl = v->ctrl + g * GROUP_WIDTH;
+        // Only slots whose 7-bit tag matches are compared for real.
+        for (uint32_t match = groupMatch(ctrl, tag); match; match &= match - 1) {
+            size_t s = g * GROUP_WIDTH + (size_t)lowestBit(match);
+            const VocabSlot *slot = &v->slots[s];
+            if (slot->key == key &&
+                (len <= INLINE_KEY_BYTES ||
+                 (arenaLength(&v->arena, slot->term) == len &&
+                  memcmp(arenaString(&v->arena, slot->term) + INLINE_KEY_BYTES, str + INLINE_KEY_BYTES,
+                         len - INLINE_KEY_BYTES) == 0))) {
+                return (long)s;
+            }
+        }
+        // An EMPTY byte in the group means the probe sequence ends here: the term is absent.
+        if (groupMatch(ctrl, CTRL_EMPTY)) {
+            return -1;
+        }
+        g = (g + step) & groupMask;
+    }
+}
+
+// insertNew:
+// Adds a term that findSlot() reported as absent, with column 'newCol'. Returns its slot index.
+static size_t insertNew(Vocabulary *v, const char *str, size_t len, uint64_t hash, int newCol) {
+    // Keep the load factor at most 7/8: groups keep empty bytes, so probes stay short.
+    if ((v->size + 1) * 8 > v->capacity * 7) {
+        growTable(v);
+    }
+    size_t s = findEmptySlot(v, hash);
+    v->ctrl[s] = hashH2(hash);
+    v->slots[s].term = arenaCopyString(&v->arena, str, len);
+    v->slots[s].col = newCol;
+    v->slots[s].key = termKey(str, len);
+    v->size++;
+    return s;
+}
+
+// slotTerm: the interned string of a slot ('\0'-terminated, lives as long as the vocabulary).
+static const char *slotTerm(const Vocabulary *v, size_t s) {
+    return arenaString(&v->arena, v->slots[s].term);
+}
+
+// vocabIntern:
+// Returns the column of 'str' (of length 'len'), adding it as the next new column if needed.
+int vocabIntern(Vocabulary *v, const char *str, size_t len) {
+    uint64_t hash = hashTerm(str, len);
+    long found = findSlot(v, str, len, hash);
+    if (found >= 0) {
+        return v->slots[found].col;
+    }
+    int col = (int)v->size;
+    size_t s = insertNew(v, str, len, hash, col);
+    // Reverse map so a column can be turned back into its term.
+    if ((size_t)col >= v->termsCapacity) {
+        size_t newCapacity = v->termsCapacity ? v->termsCapacity * 2 : 1024;
+        const char **grown = (const char **)realloc((void *)v->terms, newCapacity * sizeof(const char *));
+        if (grown == NULL) {
+            fprintf(stderr, "Term list allocation failed\n");
+            exit(1);
+        }
+        v->terms = grown;
+        v->termsCapacity = newCapacity;
+    }
+    v->terms[col] = slotTerm(v, s);
+    return col;
+}
+
+// vocabFind: returns the column of 'str', or -1 if the term was never interned.
+int vocabFind(const Vocabulary *v, const char *str, size_t len) {
+    long s = findSlot(v, str, len, hashTerm(str, len));
+    return s >= 0 ? v->slots[s].col : -1;
+}
+
+// vocabFree: releases the table, the reverse map and all interned strings.
+void vocabFree(Vocabulary *v) {
+    free(v->ctrl);
+    free(v->slots);
+    free((void *)v->terms);
+    freeArena(&v->arena);
+}
+
+/* ------------------------------------------------------------------------------------------
+ * Sharded vocabulary for multi-threaded building
+ * ------------------------------------------------------------------------------------------ */
+
+// The top bits of the hash choose the shard (the low bits are used inside the shard's table, so
+// the two choices are independent). Each shard is a normal Vocabulary protected by its own mutex.
+// Column numbers are still global: a new term takes the next value of one atomic counter.
+// The reverse map terms[col] is global too, so it has its own lock; it is only taken when a term
+// is new (or looked up by column), never on the hot path of interning a known term.
+#define SHARD_BITS 6
+#define SHARD_COUNT (1 << SHARD_BITS)
+
+typedef struct {
+    pthread_mutex_t lock;
+    Vocabulary table;
+} VocabShard;
+
+typedef struct {
+    VocabShard shards[SHARD_COUNT];
+    atomic_int nextCol;
+    pthread_mutex_t termsLock; // Protects 'terms' and 'termsCapacity'
+    const char **terms;        // terms[col] is the term of column col (NULL until it is stored)
+    size_t termsCapacity;
+} ShardedVocabulary;
+
+// growShardedTerms: makes terms[col] valid; new entries start as NULL. Call with termsLock held.
+static void growShardedTerms(ShardedVocabulary *sv, size_t minCapacity) {
+    if (minCapacity <= sv->termsCapacity) {
+        return;
+    }
+    size_t newCapacity = sv->termsCapacity ? sv->termsCapacity : 1024;
+    while (newCapacity < minCapacity) {
+        newCapacity *= 2;
+    }
+    const char **grown = (const char **)realloc((void *)sv->terms, newCapacity * sizeof(const char *));
+    if (grown == NULL) {
+        fprintf(stderr, "Term list allocation failed\n");
+        exit(1);
+    }
+    memset((void *)(grown + sv->termsCapacity), 0, (newCapacity - sv->termsCapacity) * sizeof(const char *));
+    sv->terms = grown;
+    sv->termsCapacity = newCapacity;
+}
+
+// shardedVocabInit:
+// Prepares an empty sharded vocabulary. 'expectedTerms' pre-sizes the reverse map (0 is fine),
+// so that a vocabulary of known size never reallocates it while threads are inserting.
+void shardedVocabInit(ShardedVocabulary *sv, size_t expectedTerms) {
+    for (int i = 0; i < SHARD_COUNT; ++i) {
+        pthread_mutex_init(&sv->shards[i].lock, NULL);
+        vocabInit(&sv->shards[i].table);
+    }
+    atomic_init(&sv->nextCol, 0);
+    pthread_mutex_init(&sv->termsLock, NULL);
+    sv->terms = NULL;
+    sv->termsCapacity = 0;
+    growShardedTerms(sv, expectedTerms);
+}
+
+// shardedVocabIntern:
+// Thread-safe version of vocabIntern. The hash is computed before taking the lock, so the
+// lock is only held for the probe (and the string copy when the term is new).
+int shardedVocabIntern(ShardedVocabulary *sv, const char *str, size_t len) {
+    uint64_t hash = hashTerm(str, len);
+    VocabShard *shard = &sv->shards[hash >> (64 - SHARD_BITS)];
+    pthread_mutex_lock(&shard->lock);
+    int col;
+    long s = findSlot(&shard->table, str, len, hash);
+    if (s >= 0) {
+        col = shard->table.slots[s].col;
+    } else {
+        col = atomic_fetch_add(&sv->nextCol, 1);
+        size_t slot = insertNew(&shard->table, str, len, hash, col);
+        // Lock order is always shard -> terms, so this cannot deadlock.
+        pthread_mutex_lock(&sv->termsLock);
+        growShardedTerms(sv, (size_t)col + 1);
+        sv->terms[col] = slotTerm(&shard->table, slot);
+        pthread_mutex_unlock(&sv->termsLock);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return col;
+}
+
+// shardedVocabFind: thread-safe lookup, -1 if the term is unknown.
+int shardedVocabFind(ShardedVocabulary *sv, const char *str, size_t len) {
+    uint64_t hash = hashTerm(str, len);
+    VocabShard *shard = &sv->shards[hash >> (64 - SHARD_BITS)];
+    pthread_mutex_lock(&shard->lock);
+    long s = findSlot(&shard->table, str, len, hash);
+    int col = s >= 0 ? shard->table.slots[s].col : -1;
+    pthread_mutex_unlock(&shard->lock);
+    return col;
+}
+
+// shardedVocabTerm:
+// Thread-safe reverse lookup: the term of column 'col', or NULL if no such column exists yet.
+// The string lives in a shard's arena, so it stays valid until shardedVocabFree().
+const char *shardedVocabTerm(ShardedVocabulary *sv, int col) {
+    const char *term = NULL;
+    pthread_mutex_lock(&sv->termsLock);
+    if (col >= 0 && (size_t)col < sv->termsCapacity) {
+        term = sv->terms[col];
+    }
+    pthread_mutex_unlock(&sv->termsLock);
+    return term;
+}
+
+// shardedVocabFree: releases every shard and the reverse map.
+void shardedVocabFree(ShardedVocabulary *sv) {
+    for (int i = 0; i < SHARD_COUNT; ++i) {
+        vocabFree(&sv->shards[i].table);
+        pthread_mutex_destroy(&sv->shards[i].lock);
+    }
+    free((void *)sv->terms);
+    pthread_mutex_destroy(&sv->termsLock);
+}
+
+/* ------------------------------------------------------------------------------------------
+ * Demo
+ * ------------------------------------------------------------------------------------------ */
+
+// A token is just a pointer into the text plus a length: no copies while tokenizing.
+typedef struct {
+    const char *str;
+    size_t len;
+} Token;
+
+// The same triplet type as in sparse_matrix_repres.c
+typedef struct {
+    int row;   // The row index of the non-zero element
+    int col;   // The column index of the non-zero element
+    int value; // The actual non-zero value at that position
+} SparseElement;
+
+// Work item for one thread of the sharded demo.
+typedef struct {
+    ShardedVocabulary *vocab;
+    const Token *tokens;
+    size_t begin, end;
+} InternJob;
+
+static void *internWorker(void *arg) {
+    InternJob *job = (InternJob *)arg;
+    for (size_t i = job->begin; i < job->end; ++i) {
+        shardedVocabIntern(job->vocab, job->tokens[i].str, job->tokens[i].len);
+    }
+    return NULL;
+}
+
+// wallSeconds: wall-clock time (clock() would add up the CPU time of all threads).
+static double wallSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    // 1. Bag-of-words for three tiny documents: term strings become column indices.
+    const char *documents[3] = {
+        "the cat sat on the mat",
+        "the dog sat",
+        "a cat and a dog"
+    };
+    Vocabulary vocab;
+    vocabInit(&vocab);
+    SparseElement elements[32];
+    int nonZeroCount = 0;
+    for (int d = 0; d < 3; ++d) {
+        const char *p = documents[d];
+        while (*p) {
+            while (*p == ' ') p++;
+            const char *start = p;
+            while (*p && *p != ' ') p++;
+            if (p == start) continue;
+            int col = vocabIntern(&vocab, start, (size_t)(p - start));
+            // Count repeated terms in the same document in the same element.
+            int k = 0;
+            while (k < nonZeroCount && !(elements[k].row == d && elements[k].col == col)) k++;
+            if (k == nonZeroCount) {
+                elements[nonZeroCount++] = (SparseElement){d, col, 0};
+            }
+            elements[k].value++;
+        }
+    }
+    printf("Vocabulary of %zu terms. Sparse Matrix (3 x %zu):\n", vocab.size, vocab.size);
+    for (int i = 0; i < nonZeroCount; ++i) {
+        printf("Row: %d, Col: %d (%s), Value: %d\n",
+            elements[i].row, elements[i].col, vocab.terms[elements[i].col], elements[i].value);
+    }
+    printf("Column of \"dog\": %d, column of \"bird\": %d\n",
+        vocabFind(&vocab, "dog", 3), vocabFind(&vocab, "bird", 4));
+    vocabFree(&vocab);
+
+    // 2. A synthetic corpus: 20M tokens drawn from a Zipf-like distribution over 2M words,
+    //    so a few words are very frequent and most are rare, as in real text.
+    size_t tokenCount = 20000000;
+    int wordCount = 2000000;
+    char *text = (char *)malloc(tokenCount * 12);
+    Token *tokens = (Token *)malloc(tokenCount * sizeof(Token));
+    if (text == NULL || tokens == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    uint64_t rng = 88172645463325252ull;
+    size_t textUsed = 0;
+    for (size_t i = 0; i < tokenCount; ++i) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; // xorshift64
+        double u = (double)(rng >> 11) / 9007199254740992.0;
+        int word = (int)(wordCount * u * u * u);
+        int n = sprintf(text + textUsed, "w%d", word);
+        tokens[i].str = text + textUsed;
+        tokens[i].len = (size_t)n;
+        textUsed += (size_t)n + 1;
+    }
+
+    double start = wallSeconds();
+    vocabInit(&vocab);
+    for (size_t i = 0; i < tokenCount; ++i) {
+        vocabIntern(&vocab, tokens[i].str, tokens[i].len);
+    }
+    double buildSeconds = wallSeconds() - start;
+
+    start = wallSeconds();
+    int misses = 0;
+    for (size_t i = 0; i < tokenCount; ++i) {
+        misses += vocabFind(&vocab, tokens[i].str, tokens[i].len) < 0;
+    }
+    double lookupSeconds = wallSeconds() - start;
+    printf("Single table: %zu tokens -> %zu terms, build %.2f Mtok/s, lookup %.2f Mtok/s, misses %d\n",
+        tokenCount, vocab.size, tokenCount / buildSeconds / 1e6, tokenCount / lookupSeconds / 1e6, misses);
+
+    // 3. The same corpus interned by 4 threads into the sharded vocabulary.
+    enum { THREADS = 4 };
+    ShardedVocabulary *sharded = (ShardedVocabulary *)malloc(sizeof(ShardedVocabulary));
+    if (sharded == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    // The single-table run tells us the vocabulary size, so the reverse map can be pre-sized.
+    shardedVocabInit(sharded, vocab.size);
+    pthread_t threads[THREADS];
+    InternJob jobs[THREADS];
+    start = wallSeconds();
+    for (int t = 0; t < THREADS; ++t) {
+        jobs[t] = (InternJob){sharded, tokens, tokenCount * t / THREADS, tokenCount * (t + 1) / THREADS};
+        if (pthread_create(&threads[t], NULL, internWorker, &jobs[t]) != 0) {
+            printf("Could not create thread %d\n", t);
+            for (int j = 0; j < t; ++j) {
+                pthread_join(threads[j], NULL);
+            }
+            return 1;
+        }
+    }
+    for (int t = 0; t < THREADS; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    double shardedSeconds = wallSeconds() - start;
+
+    int distinct = atomic_load(&sharded->nextCol);
+    printf("Sharded (%d threads, %d shards): %d terms, build %.2f Mtok/s (%s)\n",
+        THREADS, SHARD_COUNT, distinct, tokenCount / shardedSeconds / 1e6,
+        (size_t)distinct == vocab.size ? "same vocabulary size" : "SIZE MISMATCH");
+    int shardedCol = shardedVocabFind(sharded, "w0", 2);
+    int singleCol = vocabFind(&vocab, "w0", 2);
+    printf("Column of \"w0\": single %d, sharded %d (%s)\n", singleCol, shardedCol,
+        singleCol == shardedCol ? "same id" : "ids differ: they follow insertion order");
+    printf("Sharded column %d maps back to \"%s\", column 0 to \"%s\"\n",
+        shardedCol, shardedVocabTerm(sharded, shardedCol), shardedVocabTerm(sharded, 0));
+    int roundTripErrors = 0;
+    for (int col = 0; col < distinct; ++col) {
+        const char *term = shardedVocabTerm(sharded, col);
+        roundTripErrors += term == NULL || shardedVocabFind(sharded, term, strlen(term)) != col;
+    }
+    printf("Every sharded column maps back to its term: %s\n", roundTripErrors == 0 ? "OK" : "MISMATCH");
+
+    shardedVocabFree(sharded);
+    free(sharded);
+    vocabFree(&vocab);
+    free(tokens);
+    free(text);
+    return 0;
+}
+
+// In summary:
+// - One flat array of slots plus one byte of hash per slot; SSE2 checks 16 slots per instruction.
+// - Each distinct term is copied once into an arena; slots are 16 bytes with a 32-bit handle to it.
+// - Terms of up to 7 bytes are compared inside the slot, without touching the arena.
+// - Growing the table re-hashes terms (rare), instead of paying for a stored hash in every slot.
+// - The sharded version spreads terms over 64 locked tables with globally unique column ids.
+//
+// Compile the program
+// gcc -O2 -o swiss_table_vocabulary swiss_table_vocabulary.c -lpthread
@@ -4,6 +4,7 @@
 
 #include <stdio.h> 
 
+// Note: int overflows at 13!. See efficiency_and_memory_optimization/combinatorics_engine.c for large n.
 int factorial(int n) { // function to calculate factorial
     if (n == 0 || n == 1)
         return 1;
@@ -4,6 +4,7 @@
 
 #include <stdio.h> // For input and output functions (printf, scanf)
 #include <stdlib.h> // For memory management functions (malloc, free)
+#include <stdint.h> // For SIZE_MAX (largest value a size_t can hold)
 
 //Declare main function <--
 int main() {
@@ -11,9 +12,18 @@ int main() {
     int n, *arr; // n (store the # of elements in the array) *arr= (allocate memory for an int array)
     // Ask user for input <--
     printf("Enter number of elements: "); // Display the message for the user
-    scanf("%d", &n); // Reads an integer value from the user and stores it in n.
+    // Read the Input and Check it <--
+    // scanf reads an integer value from the user into n and returns how many values it read:
+    // if it is not 1 the input was not a number and n is still uninitialized.
+    // n must be positive, and n * sizeof(int) must not overflow size_t (it would wrap around
+    // and malloc would return a block much smaller than we think).
+    if (scanf("%d", &n) != 1 || n <= 0 || (size_t)n > SIZE_MAX / sizeof(int)) {
+        printf("Invalid number of elements\n");
+        return 1;
+    }
+    // For an array that can grow, see efficiency_and_memory_optimization/growable_dynamic_array.c
     // Allocate memory dinamically <--
-    arr = (int*)malloc(n * sizeof(int));
+    arr = (int*)malloc((size_t)n * sizeof(int));
     // malloc: Allocates a block of memory  big enough to store n integers
     // n * sizeof(int): Calculates the total memory required for n integers
     // (int*): Casts the memory block to be used as an integer pointer